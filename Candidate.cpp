@@ -8,70 +8,206 @@ static const char* TITLE = "Class Slide";
 static const float CANDIDATE_SPACE = 50.0f;
 const float CANDITATE_SCREEN_H_PROPORTION = 0.25f;
 const float WINNER_SCREEN_H_PROPORTION = 0.70f;
-static const char* CARD_TEXTURE_PATH = "asset\\folded.jpg";
+static const Uint64 FLIP_TIME = 400;
 
-Slide::Slide(SDL_Window* window, SDL_Renderer* renderer, const char* image_path, SDL_Texture* back_texture)
-    : window_(window), renderer_(renderer), back_texture_(back_texture)
+Back_Face_Cache::Back_Face_Cache(SDL_Renderer* renderer)
+    : renderer_(renderer)
 {
-    texture_ = IMG_LoadTexture(renderer_, image_path);
-    if (texture_ == NULL)
+}
+
+Back_Face_Cache::~Back_Face_Cache()
+{
+    Clear();
+}
+
+SDL_Texture* Back_Face_Cache::Get(int w, int h)
+{
+    if (renderer_ == NULL || w <= 0 || h <= 0)
+        return NULL;
+
+    auto found = textures_.find(std::make_pair(w, h));
+    if (found != textures_.end())
+        return found->second;
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+    if (texture == NULL)
+    {
+        Logging_Write("SDL_CreateTexture %dx%d failed: %s", w, h, SDL_GetError());
+        return NULL;
+    }
+
+    // card back: border, then checker tiles, all batched in one fill
+    // called mid frame, so keep caller's target and draw color
+    SDL_Texture* prev_target = SDL_GetRenderTarget(renderer_);
+    Uint8 prev_r, prev_g, prev_b, prev_a;
+    SDL_GetRenderDrawColor(renderer_, &prev_r, &prev_g, &prev_b, &prev_a);
+    SDL_SetRenderTarget(renderer_, texture);
+    SDL_SetRenderDrawColor(renderer_, 230, 230, 230, SDL_ALPHA_OPAQUE);
+    SDL_RenderClear(renderer_);
+
+    const float border = SDL_max(2.0f, h / 24.0f);
+    SDL_FRect inner;
+    inner.x = border;
+    inner.y = border;
+    inner.w = w - border * 2.0f;
+    inner.h = h - border * 2.0f;
+    SDL_SetRenderDrawColor(renderer_, 140, 20, 30, SDL_ALPHA_OPAQUE);
+    SDL_RenderFillRect(renderer_, &inner);
+
+    const float tile = SDL_max(4.0f, h / 12.0f);
+    std::vector<SDL_FRect> tiles;
+    int row = 0;
+    for (float ty = inner.y; ty < inner.y + inner.h; ty += tile, row++)
+    {
+        int col = 0;
+        for (float tx = inner.x; tx < inner.x + inner.w; tx += tile, col++)
+        {
+            if ((row + col) % 2 != 0)
+                continue;
+            SDL_FRect r;
+            r.x = tx;
+            r.y = ty;
+            r.w = SDL_min(tile, inner.x + inner.w - tx);
+            r.h = SDL_min(tile, inner.y + inner.h - ty);
+            tiles.push_back(r);
+        }
+    }
+    SDL_SetRenderDrawColor(renderer_, 180, 40, 50, SDL_ALPHA_OPAQUE);
+    SDL_RenderFillRects(renderer_, tiles.data(), (int)tiles.size());
+    SDL_SetRenderTarget(renderer_, prev_target);
+    SDL_SetRenderDrawColor(renderer_, prev_r, prev_g, prev_b, prev_a);
+
+    tile_cnt_ += (Uint32)tiles.size();
+    textures_[std::make_pair(w, h)] = texture;
+    return texture;
+}
+
+void Back_Face_Cache::Clear()
+{
+    for (auto& it : textures_)
+    {
+        SDL_DestroyTexture(it.second);
+    }
+    textures_.clear();
+}
+
+//return tiles drawn since last call
+Uint32 Back_Face_Cache::Take_Tile_Count()
+{
+    Uint32 cnt = tile_cnt_;
+    tile_cnt_ = 0;
+    return cnt;
+}
+
+Shared_Image::Shared_Image(const char* image_path, const std::vector<SDL_Renderer*>& renderers, SDL_Window* window)
+{
+    SDL_Surface* surface = IMG_Load(image_path);
+    if (surface == NULL)
     {
         char* msg = NULL;
-        SDL_asprintf(&msg, "IMG_LoadTexture err: %s", SDL_GetError());
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, TITLE, msg, window_);
+        SDL_asprintf(&msg, "IMG_Load err: %s", SDL_GetError());
+        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, TITLE, msg, window);
         Logging_Write(msg);
         SDL_free(msg);
         return;
     }
-    img_width_ = texture_->w;
-    img_height_ = texture_->h;
+    width_ = surface->w;
+    height_ = surface->h;
 
-    Init_Position();
+    // only the upload is per renderer
+    for (auto it : renderers)
+    {
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(it, surface);
+        if (texture == NULL)
+        {
+            Logging_Write("SDL_CreateTextureFromSurface %s failed: %s", image_path, SDL_GetError());
+            continue;
+        }
+        textures_.push_back(std::make_pair(it, texture));
+    }
+    SDL_DestroySurface(surface);
 }
 
-Slide::~Slide()
+Shared_Image::~Shared_Image()
 {
-    if (texture_ != NULL)
+    for (auto& it : textures_)
     {
-        SDL_DestroyTexture(texture_);
+        SDL_DestroyTexture(it.second);
     }
 }
 
+SDL_Texture* Shared_Image::Get_Texture(SDL_Renderer* renderer) const
+{
+    for (auto& it : textures_)
+    {
+        if (it.first == renderer)
+            return it.second;
+    }
+    return NULL;
+}
+
+int Shared_Image::Get_Width() const
+{
+    return width_;
+}
+
+int Shared_Image::Get_Height() const
+{
+    return height_;
+}
+
+Slide::Slide(SDL_Window* window, std::shared_ptr<Shared_Image> image)
+    : window_(window), image_(image)
+{
+    if (image_ == nullptr || image_->Get_Width() == 0)
+        return;
+    img_width_ = image_->Get_Width();
+    img_height_ = image_->Get_Height();
+
+    Init_Position();
+}
+
+Slide::~Slide()
+{
+}
+
 void Slide::Set_Position(float x, float y)
 {
     x_ = x;
     y_ = y;
 }
 
-void Slide::Render()
+void Slide::Render(const Slide_Output& out)
 {
-    Render(0.0f, 0.0f);
+    Render(out, 0.0f, 0.0f);
 }
 
-void Slide::Render(float x_off, float y_off)
+void Slide::Render(const Slide_Output& out, float x_off, float y_off)
 {
-    if (window_ == NULL || texture_ == NULL || back_texture_ == NULL)
+    if (window_ == NULL || img_width_ == 0 || out.back_cache == nullptr)
         return;
 
     SDL_FRect dst_rect;
 
-    dst_rect.x = x_ + x_off;
-    dst_rect.y = y_ + y_off;
-    dst_rect.w = width_;
-    dst_rect.h = height_;
-    if (turn_back_)
-    {
-        SDL_RenderTextureTiled(renderer_, back_texture_, NULL, 1.0f, &dst_rect);
-    }
+    // flip squeezes the card around its center, back face shows after half way
+    const float squeeze = fabsf(cosf(flip_ * SDL_PI_F));
+    const float w = width_ * out.scale;
+    dst_rect.w = w * squeeze;
+    dst_rect.h = height_ * out.scale;
+    dst_rect.x = (x_ + x_off) * out.scale + out.x_off + (w - dst_rect.w) / 2.0f;
+    dst_rect.y = (y_ + y_off) * out.scale + out.y_off;
+    SDL_Texture* texture = NULL;
+    if (flip_ >= 0.5f)
+        texture = out.back_cache->Get((int)w, (int)dst_rect.h);
     else
-    {
-        SDL_RenderTexture(renderer_, texture_, NULL, &dst_rect);
-    }
+        texture = image_->Get_Texture(out.renderer);
+    if (texture != NULL)
+        SDL_RenderTexture(out.renderer, texture, NULL, &dst_rect);
 }
 
 bool Slide::Is_Out_Of_Window() const
 {
-    if (window_ == NULL || texture_ == NULL)
+    if (window_ == NULL || img_width_ == 0)
         return true;
 
     // scale candidate image by height proportionally according to window size
@@ -110,7 +246,7 @@ void Slide::Get_Rect(SDL_FRect& r) const
 
 void Slide::Init_Position()
 {
-    if (window_ == NULL || texture_ == NULL)
+    if (window_ == NULL || img_width_ == 0)
         return;
 
     Update_Size_By_Window();
@@ -130,7 +266,7 @@ bool Slide::Win(Uint64 elapse)
 {
     elapse_ += elapse;
 
-    if (window_ == NULL || texture_ == NULL)
+    if (window_ == NULL || img_width_ == 0)
         return true;
 
     int win_w, win_h;
@@ -164,7 +300,7 @@ bool Slide::Win(Uint64 elapse)
 
 void Slide::Update_Size_By_Window()
 {
-    if (window_ == NULL || texture_ == NULL)
+    if (window_ == NULL || img_width_ == 0)
         return;
 
     // scale candidate image by height proportionally according to window size
@@ -180,37 +316,153 @@ void Slide::Update_Size_By_Window()
     width_ = img_w_h_ratio * height_;
 }
 
-void Slide::Set_Turn_Back(bool turn_back)
+void Slide::Set_Turn_Back(bool turn_back, bool animate)
 {
     turn_back_ = turn_back;
+    if (!animate)
+        flip_ = turn_back_ ? 1.0f : 0.0f;
+}
+
+void Slide::Update_Flip(Uint64 elapse)
+{
+    const float step = (float)elapse / FLIP_TIME;
+    if (turn_back_)
+        flip_ = SDL_min(flip_ + step, 1.0f);
+    else
+        flip_ = SDL_max(flip_ - step, 0.0f);
 }
 
-Lottery_Slide_Show::Lottery_Slide_Show(SDL_Window* window, SDL_Renderer* renderer, std::vector<std::string>& candidate_files)
-    : window_(window), renderer_(renderer), candidate_files_(candidate_files), generator_(rd_())
+Lottery_Slide_Show::Lottery_Slide_Show(SDL_Window* window, SDL_Renderer* renderer, std::vector<std::string>& candidate_files, Uint32 seed)
+    : generator_(seed), window_(window), candidate_files_(candidate_files)
 {
-    back_texture_ = IMG_LoadTexture(renderer_, CARD_TEXTURE_PATH);
-    if (back_texture_ == NULL)
+    Add_Output(window, renderer);
+}
+
+Lottery_Slide_Show::~Lottery_Slide_Show()
+{
+}
+
+// extra window driven by the same simulation, add before first Run
+bool Lottery_Slide_Show::Add_Output(SDL_Window* window, SDL_Renderer* renderer)
+{
+    if (window == NULL || renderer == NULL)
+        return false;
+
+    Slide_Output out;
+    out.window = window;
+    out.renderer = renderer;
+    out.back_cache = std::make_shared<Back_Face_Cache>(renderer);
+    outputs_.push_back(out);
+    renderers_.push_back(renderer);
+    return true;
+}
+
+// uniform in [lo, hi], the same on every standard library:
+// mt19937 output is fully specified, std distributions are not
+Uint32 Lottery_Slide_Show::Random_Range(Uint32 lo, Uint32 hi)
+{
+    const Uint64 span = (Uint64)hi - lo + 1;
+    const Uint64 bound = (0x100000000ull / span) * span;
+    Uint64 v;
+    do
     {
-        char* msg = NULL;
-        SDL_asprintf(&msg, "IMG_LoadTexture err: %s", SDL_GetError());
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, TITLE, msg, window_);
-        Logging_Write(msg);
-        SDL_free(msg);
+        v = generator_();
+    } while (v >= bound);
+    return lo + (Uint32)(v % span);
+}
+
+//return true: winner was chosen since last call
+bool Lottery_Slide_Show::Take_Winner(std::string& winner)
+{
+    if (new_winner_.empty())
+        return false;
+
+    winner = std::move(new_winner_);
+    new_winner_.clear();
+    return true;
+}
+
+const Render_Stats& Lottery_Slide_Show::Get_Render_Stats() const
+{
+    return stats_;
+}
+
+// render target content is lost on device reset, redraw card backs on demand
+void Lottery_Slide_Show::Reset_Render_Targets()
+{
+    for (auto& it : outputs_)
+        it.back_cache->Clear();
+}
+
+// fit the whole simulation space into each output, letterboxed and centered,
+// so slides enter and leave at the edges of the area on every window
+void Lottery_Slide_Show::Update_Output_Layout(Slide_Output& out)
+{
+    int sim_w, sim_h, out_w, out_h;
+    if (!SDL_GetWindowSize(window_, &sim_w, &sim_h) || !SDL_GetWindowSize(out.window, &out_w, &out_h) || sim_w <= 0 || sim_h <= 0)
+    {
+        Logging_Write("SDL_GetWindowSize failed: %s", SDL_GetError());
         return;
     }
+
+    out.scale = SDL_min((float)out_w / (float)sim_w, (float)out_h / (float)sim_h);
+    out.x_off = ((float)out_w - (float)sim_w * out.scale) / 2.0f;
+    out.y_off = ((float)out_h - (float)sim_h * out.scale) / 2.0f;
+    out.area.x = (int)out.x_off;
+    out.area.y = (int)out.y_off;
+    out.area.w = out_w - out.area.x * 2;
+    out.area.h = out_h - out.area.y * 2;
 }
 
-Lottery_Slide_Show::~Lottery_Slide_Show()
+//return false: window is not an output
+bool Lottery_Slide_Show::Get_Output_Area(SDL_Window* window, SDL_FRect& area)
 {
-    if (back_texture_ != NULL)
+    for (auto& it : outputs_)
     {
-        SDL_DestroyTexture(back_texture_);
+        if (it.window != window)
+            continue;
+
+        Update_Output_Layout(it);
+        area.x = (float)it.area.x;
+        area.y = (float)it.area.y;
+        area.w = (float)it.area.w;
+        area.h = (float)it.area.h;
+        return true;
+    }
+    return false;
+}
+
+void Lottery_Slide_Show::Render_Output(Slide_Output& out)
+{
+    Update_Output_Layout(out);
+    SDL_SetRenderClipRect(out.renderer, &out.area);
+    for (auto& it : slide_vec_)
+    {
+        if (state_ == Lottery_Slide_Show_State::IDLE)
+        {
+            SDL_FRect r;
+            it->Get_Rect(r);
+            it->Render(out, 0.0f, abs(sin(r.x / 100.0f) * 50.0f));
+        }
+        else
+        {
+            it->Render(out);
+        }
+        stats_.draws += 1;
     }
+    if (the_winner_)
+    {
+        the_winner_->Render(out);
+        stats_.draws += 1;
+    }
+    SDL_SetRenderClipRect(out.renderer, NULL);
+    stats_.tiles += out.back_cache->Take_Tile_Count();
 }
 
-void Lottery_Slide_Show::Run(Uint64 elapse)
+void Lottery_Slide_Show::Run(Uint64 elapse, bool enter_down)
 {
     state_elapse_ += elapse;
+    stats_ = Render_Stats();
 
     if (candidate_files_.empty())
         return ;
@@ -233,10 +485,17 @@ void Lottery_Slide_Show::Run(Uint64 elapse)
     }
     if (win_w > most_right_edge && (float)win_w - most_right_edge >= CANDIDATE_SPACE)
     {
-        const char* new_candidate_file = candidate_files_[candidate_idx].c_str();
-        std::shared_ptr<Slide> newSlide = std::make_shared<Slide>(window_, renderer_, new_candidate_file, back_texture_);
+        // same candidate already on screen shares its decoded image
+        const std::string& new_candidate_file = candidate_files_[candidate_idx];
+        std::shared_ptr<Shared_Image> image = images_[new_candidate_file].lock();
+        if (!image)
+        {
+            image = std::make_shared<Shared_Image>(new_candidate_file.c_str(), renderers_, window_);
+            images_[new_candidate_file] = image;
+        }
+        std::shared_ptr<Slide> newSlide = std::make_shared<Slide>(window_, image);
         if (state_ == Lottery_Slide_Show_State::FOLD_RUN)
-            newSlide->Set_Turn_Back(true);
+            newSlide->Set_Turn_Back(true, false);
 
         if (state_ == Lottery_Slide_Show_State::SHOW_WINNER && winner_idx_ == candidate_idx)
             the_winner_ = newSlide;
@@ -304,22 +563,17 @@ void Lottery_Slide_Show::Run(Uint64 elapse)
         (*iter)->Get_Rect(r);        
         if ((*iter)->Is_Out_Of_Window() == false)
         {
+            (*iter)->Update_Flip(elapse);
             switch (state_)
             {
             case Lottery_Slide_Show_State::IDLE:
-                (*iter)->Set_Position(r.x - movement_per_sec * elapse / 1000.0f, r.y);
-                (*iter)->Render(0.0f, abs(sin(r.x / 100.0f) * 50.0f));
-                break;
-
             case Lottery_Slide_Show_State::FOLD_RUN:
                 (*iter)->Set_Position(r.x - movement_per_sec * elapse / 1000.0f, r.y);
-                (*iter)->Render();
                 break;
 
             case Lottery_Slide_Show_State::SHOW_WINNER:
                 if(!stopped_)
                     (*iter)->Set_Position(r.x - movement_per_sec * elapse / 1000.0f, r.y);
-                (*iter)->Render();
                 break;
             }            
             ++iter;
@@ -329,21 +583,29 @@ void Lottery_Slide_Show::Run(Uint64 elapse)
             iter = slide_vec_.erase(iter);
         }
     }
-    if (the_winner_)
-        the_winner_->Render();
+    for (auto& it : outputs_)
+        Render_Output(it);
+    if (state_ == Lottery_Slide_Show_State::FOLD_RUN)
+    {
+        fold_max_stats_.draws = SDL_max(fold_max_stats_.draws, stats_.draws);
+        fold_max_stats_.tiles = SDL_max(fold_max_stats_.tiles, stats_.tiles);
+    }
 
     // change state
     if (state_ == Lottery_Slide_Show_State::FOLD_RUN && state_elapse_ > fold_time_)
     {
-        int max = candidate_files_.size();
-        std::uniform_int_distribution<int> unif(0, max);
-        winner_idx_ = unif(generator_);
+        Logging_Write("Fold run peak %u draws, %u tiles per frame", fold_max_stats_.draws, fold_max_stats_.tiles);
+        fold_max_stats_ = Render_Stats();
+        winner_idx_ = (int)Random_Range(0, (Uint32)candidate_files_.size() - 1);
         Logging_Write("Winner is %s", candidate_files_[winner_idx_].c_str());
+        new_winner_ = candidate_files_[winner_idx_];
+        // folded cards flip back to their faces as the strip slows down
+        for (auto& it : slide_vec_)
+            it->Set_Turn_Back(false, true);
         state_elapse_ = 0;
         state_ = Lottery_Slide_Show_State::SHOW_WINNER;
     }
-    const bool* keystate = SDL_GetKeyboardState(NULL);
-    if (keystate[SDL_SCANCODE_RETURN])
+    if (enter_down)
     {
         switch (state_)
         {
@@ -352,8 +614,9 @@ void Lottery_Slide_Show::Run(Uint64 elapse)
             if (state_elapse_ > 1000)
             {
                 Logging_Write("Start lottery");
-                std::uniform_int_distribution<Uint64> unif(6000, 9000);
-                fold_time_ = unif(generator_);
+                fold_time_ = Random_Range(6000, 9000);
+                for (auto& it : slide_vec_)
+                    it->Set_Turn_Back(true, true);
                 state_elapse_ = 0;
                 state_ = Lottery_Slide_Show_State::FOLD_RUN;
             }
@@ -384,3 +647,23 @@ void Lottery_Slide_Show::Run(Uint64 elapse)
         }
     }
 }
+
+// append path/file for every file in path matching pattern
+bool Candidate_List_Files(std::vector<std::string>& v, const char* path, const char* pattern)
+{
+    int filenames_cnt = 0;
+    char** filenames = SDL_GlobDirectory(path, pattern, SDL_GLOB_CASEINSENSITIVE, &filenames_cnt);
+    if (filenames == NULL)
+        return false;
+
+    for (int ii = 0; ii < filenames_cnt; ii++)
+    {
+        char* full_path = NULL;
+        SDL_asprintf(&full_path, "%s/%s", path, filenames[ii]);
+        v.push_back(full_path);
+        SDL_free(full_path);
+    }
+
+    SDL_free(filenames);
+    return true;
+}
@@ -6,25 +6,76 @@
 #include <string>
 #include <memory>
 #include <random>
+#include <map>
+
+// card back drawn procedurally into one render target per card size
+class Back_Face_Cache {
+public:
+	Back_Face_Cache(SDL_Renderer* renderer);
+	~Back_Face_Cache();
+	Back_Face_Cache(const Back_Face_Cache&) = delete;
+	Back_Face_Cache& operator=(const Back_Face_Cache&) = delete;
+	SDL_Texture* Get(int w, int h);
+	void Clear();
+	Uint32 Take_Tile_Count();
+
+protected:
+	SDL_Renderer* renderer_{ NULL };
+	std::map<std::pair<int, int>, SDL_Texture*> textures_;
+	Uint32 tile_cnt_{ 0 };
+};
+
+struct Render_Stats {
+	Uint32 draws{ 0 };
+	Uint32 tiles{ 0 };
+};
+
+// image decoded once, uploaded to every renderer given
+// window: parent of the error message box, keeps it above fullscreen windows
+class Shared_Image {
+public:
+	Shared_Image(const char* image_path, const std::vector<SDL_Renderer*>& renderers, SDL_Window* window);
+	~Shared_Image();
+	Shared_Image(const Shared_Image&) = delete;
+	Shared_Image& operator=(const Shared_Image&) = delete;
+	SDL_Texture* Get_Texture(SDL_Renderer* renderer) const;
+	int Get_Width() const;
+	int Get_Height() const;
+
+protected:
+	std::vector<std::pair<SDL_Renderer*, SDL_Texture*>> textures_;
+	int width_{ 0 };
+	int height_{ 0 };
+};
+
+// one window showing the slide show, simulation space fit into it and centered
+struct Slide_Output {
+	SDL_Window* window{ NULL };
+	SDL_Renderer* renderer{ NULL };
+	std::shared_ptr<Back_Face_Cache> back_cache;
+	float scale{ 1.0f };
+	float x_off{ 0.0f };
+	float y_off{ 0.0f };
+	SDL_Rect area{ 0, 0, 0, 0 };	// simulation space on this window, drawing is clipped to it
+};
 
 class Slide {
 public:
-	Slide(SDL_Window* window, SDL_Renderer* renderer, const char* image_path, SDL_Texture* back_texture);
+	Slide(SDL_Window* window, std::shared_ptr<Shared_Image> image);
 	~Slide();
 	void Set_Position(float x, float y);
-	void Render();
-	void Render(float x_off, float y_off);
+	void Render(const Slide_Output& out);
+	void Render(const Slide_Output& out, float x_off, float y_off);
 	bool Is_Out_Of_Window() const;
 	void Get_Rect(SDL_FRect& r) const;
 	void Init_Position();
 	bool Win(Uint64 elapse);
-	void Set_Turn_Back(bool turn_back);
+	void Set_Turn_Back(bool turn_back, bool animate);
+	void Update_Flip(Uint64 elapse);
 
 protected:
-	SDL_Window* window_{ NULL };
-	SDL_Renderer* renderer_{ NULL };
-	SDL_Texture* texture_{ NULL };
-	SDL_Texture* back_texture_{ NULL };
+	SDL_Window* window_{ NULL };	// simulation window, geometry follows its size
+	std::shared_ptr<Shared_Image> image_;
 	float x_{ 0.0f };
 	float y_{ 0.0f };
 	float width_{ 0.0f };
@@ -33,6 +84,7 @@ protected:
 	int img_height_{ 0 };
 	Uint64 elapse_{ 0 };
 	bool turn_back_{ false };
+	float flip_{ 0.0f };	// 0: face, 1: back
 
 	void Update_Size_By_Window();
 };
@@ -45,18 +97,23 @@ enum class Lottery_Slide_Show_State {
 
 class Lottery_Slide_Show {
 public:
-	Lottery_Slide_Show(SDL_Window* window, SDL_Renderer* renderer, std::vector<std::string>& candidate_files);
+	Lottery_Slide_Show(SDL_Window* window, SDL_Renderer* renderer, std::vector<std::string>& candidate_files, Uint32 seed);
 	~Lottery_Slide_Show();
-	void Run(Uint64 elapse);
+	bool Add_Output(SDL_Window* window, SDL_Renderer* renderer);
+	bool Get_Output_Area(SDL_Window* window, SDL_FRect& area);
+	void Run(Uint64 elapse, bool enter_down);
+	bool Take_Winner(std::string& winner);
+	const Render_Stats& Get_Render_Stats() const;
+	void Reset_Render_Targets();
 
 private:
 	int winner_idx_{ 0 };
-	std::random_device rd_;
-	std::default_random_engine generator_;
+	std::mt19937 generator_;
 	Lottery_Slide_Show_State state_{ Lottery_Slide_Show_State::IDLE };
 	SDL_Window* window_{ NULL };
-	SDL_Renderer* renderer_{ NULL };
-	SDL_Texture* back_texture_{ NULL };
+	std::vector<Slide_Output> outputs_;
+	std::vector<SDL_Renderer*> renderers_;
+	std::map<std::string, std::weak_ptr<Shared_Image>> images_;
 	std::vector<std::string>& candidate_files_;
 	Uint64 state_elapse_{ 0 };
 	Uint64 fold_time_{ 0 };
@@ -64,6 +121,15 @@ private:
 	std::vector<std::shared_ptr<Slide>> slide_vec_;
 	std::shared_ptr<Slide> the_winner_;
 	bool stopped_{ false };
+	std::string new_winner_;
+	Render_Stats stats_;
+	Render_Stats fold_max_stats_;
+
+	Uint32 Random_Range(Uint32 lo, Uint32 hi);
+	void Update_Output_Layout(Slide_Output& out);
+	void Render_Output(Slide_Output& out);
 };
 
+bool Candidate_List_Files(std::vector<std::string>& v, const char* path, const char* pattern);
+
 #endif
@@ -34,7 +34,7 @@ bool Logging_Init()
 	datetime = localtime(&timestamp);
 	strftime(time_str, sizeof(time_str), "%F-%H-%M-%S", datetime);
 	char* Log_path = NULL;
-	SDL_asprintf(&Log_path, "%s\\session-%s.log", LOGGING_DIR, time_str) ;
+	SDL_asprintf(&Log_path, "%s/session-%s.log", LOGGING_DIR, time_str) ;
 	fLog = SDL_IOFromFile(Log_path, "w");
 	SDL_free(Log_path);
 	if (fLog == NULL)
@@ -0,0 +1,222 @@
+#include <SDL3/SDL.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "Trace.h"
+#include "Logging.h"
+
+static const char TRACE_MAGIC[4] = { 'X', 'A', 'C', 'T' };
+static const Uint8 TRACE_VERSION = 2;
+static const Uint8 TRACE_FRAME_RESIZE = 0x40;
+static const Uint8 TRACE_FRAME_WINNER = 0x80;
+static SDL_IOStream* fTrace = NULL;
+static int trace_w = 0;
+static int trace_h = 0;
+
+static bool Write_String_(const char* s)
+{
+	const Uint16 len = (Uint16)SDL_min(SDL_strlen(s), (size_t)SDL_MAX_UINT16);
+	return SDL_WriteU16LE(fTrace, len) && SDL_WriteIO(fTrace, s, len) == len;
+}
+
+static bool Read_String_(std::string& s)
+{
+	Uint16 len = 0;
+	if (!SDL_ReadU16LE(fTrace, &len))
+		return false;
+	s.assign(len, '\0');
+	return len == 0 || SDL_ReadIO(fTrace, &s[0], len) == len;
+}
+
+struct Frame_Cost {
+	Uint64 elapse;
+	Uint64 cost_ns;
+	Uint32 draws;
+	Uint32 tiles;
+};
+static std::vector<Frame_Cost> replay_costs;
+
+bool Trace_Record_Open(const char* path, Uint32 seed, int win_w, int win_h, const std::vector<std::string>& candidates)
+{
+	if (fTrace != NULL)
+		return false;
+
+	fTrace = SDL_IOFromFile(path, "wb");
+	if (fTrace == NULL)
+	{
+		Logging_Write("Trace open %s failed: %s", path, SDL_GetError());
+		return false;
+	}
+
+	bool ok = SDL_WriteIO(fTrace, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == sizeof(TRACE_MAGIC);
+	ok = ok && SDL_WriteU8(fTrace, TRACE_VERSION);
+	ok = ok && SDL_WriteU32LE(fTrace, seed);
+	ok = ok && SDL_WriteS32LE(fTrace, win_w);
+	ok = ok && SDL_WriteS32LE(fTrace, win_h);
+	ok = ok && SDL_WriteU32LE(fTrace, (Uint32)candidates.size());
+	for (auto& it : candidates)
+	{
+		ok = ok && Write_String_(it.c_str());
+	}
+	if (!ok)
+	{
+		Logging_Write("Trace header write failed: %s", SDL_GetError());
+		Trace_Close();
+		return false;
+	}
+
+	trace_w = win_w;
+	trace_h = win_h;
+	Logging_Write("Recording trace %s, seed %u, %dx%d", path, seed, win_w, win_h);
+	return true;
+}
+
+bool Trace_Record_Frame(Uint64 elapse, Uint8 input, int win_w, int win_h, const char* winner)
+{
+	if (fTrace == NULL)
+		return false;
+
+	Uint8 flags = input;
+	if (win_w != trace_w || win_h != trace_h)
+		flags |= TRACE_FRAME_RESIZE;
+	if (winner != NULL)
+		flags |= TRACE_FRAME_WINNER;
+
+	bool ok = SDL_WriteU32LE(fTrace, (Uint32)elapse) && SDL_WriteU8(fTrace, flags);
+	if (flags & TRACE_FRAME_RESIZE)
+	{
+		ok = ok && SDL_WriteS32LE(fTrace, win_w) && SDL_WriteS32LE(fTrace, win_h);
+		trace_w = win_w;
+		trace_h = win_h;
+	}
+	if (flags & TRACE_FRAME_WINNER)
+		ok = ok && Write_String_(winner);
+	return ok;
+}
+
+bool Trace_Replay_Open(const char* path, Uint32& seed, int& win_w, int& win_h, std::vector<std::string>& candidates)
+{
+	if (fTrace != NULL)
+		return false;
+
+	fTrace = SDL_IOFromFile(path, "rb");
+	if (fTrace == NULL)
+	{
+		Logging_Write("Trace open %s failed: %s", path, SDL_GetError());
+		return false;
+	}
+
+	char magic[sizeof(TRACE_MAGIC)];
+	Uint8 version = 0;
+	Uint32 candidate_cnt = 0;
+	bool ok = SDL_ReadIO(fTrace, magic, sizeof(magic)) == sizeof(magic) && SDL_memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0;
+	ok = ok && SDL_ReadU8(fTrace, &version) && version == TRACE_VERSION;
+	ok = ok && SDL_ReadU32LE(fTrace, &seed);
+	ok = ok && SDL_ReadS32LE(fTrace, &win_w);
+	ok = ok && SDL_ReadS32LE(fTrace, &win_h);
+	ok = ok && SDL_ReadU32LE(fTrace, &candidate_cnt);
+	for (Uint32 ii = 0; ok && ii < candidate_cnt; ii++)
+	{
+		std::string s;
+		ok = Read_String_(s);
+		candidates.push_back(std::move(s));
+	}
+	if (!ok)
+	{
+		Logging_Write("Trace %s is not a valid trace", path);
+		Trace_Close();
+		return false;
+	}
+
+	// a missing image drops its slide, so the replay would silently diverge
+	int missing_cnt = 0;
+	for (auto& it : candidates)
+	{
+		SDL_PathInfo pi;
+		if (SDL_GetPathInfo(it.c_str(), &pi) == false || pi.type != SDL_PATHTYPE_FILE)
+		{
+			Logging_Write("Trace candidate %s not found", it.c_str());
+			missing_cnt += 1;
+		}
+	}
+	if (missing_cnt > 0)
+	{
+		Logging_Write("Trace %s needs %d missing candidates, not replaying", path, missing_cnt);
+		Trace_Close();
+		return false;
+	}
+
+	replay_costs.clear();
+	Logging_Write("Replaying trace %s, seed %u, %dx%d, %u candidates", path, seed, win_w, win_h, candidate_cnt);
+	return true;
+}
+
+//return false: no more frames
+//win_w/win_h only change on a recorded resize, winner is empty unless chosen in this frame
+bool Trace_Replay_Frame(Uint64& elapse, Uint8& input, int& win_w, int& win_h, std::string& winner)
+{
+	if (fTrace == NULL)
+		return false;
+
+	Uint32 e = 0;
+	Uint8 flags = 0;
+	if (!SDL_ReadU32LE(fTrace, &e) || !SDL_ReadU8(fTrace, &flags))
+		return false;
+	if ((flags & TRACE_FRAME_RESIZE) && !(SDL_ReadS32LE(fTrace, &win_w) && SDL_ReadS32LE(fTrace, &win_h)))
+		return false;
+	winner.clear();
+	if ((flags & TRACE_FRAME_WINNER) && !Read_String_(winner))
+		return false;
+	elapse = e;
+	input = flags & ~(TRACE_FRAME_RESIZE | TRACE_FRAME_WINNER);
+	return true;
+}
+
+void Trace_Replay_Frame_Cost(Uint64 elapse, Uint64 cost_ns, Uint32 draws, Uint32 tiles)
+{
+	replay_costs.push_back({ elapse, cost_ns, draws, tiles });
+}
+
+bool Trace_Replay_Report(const char* path)
+{
+	if (replay_costs.empty())
+		return false;
+
+	SDL_IOStream* fReport = SDL_IOFromFile(path, "w");
+	if (fReport == NULL)
+	{
+		Logging_Write("Trace report open %s failed: %s", path, SDL_GetError());
+		return false;
+	}
+
+	Uint64 total_ns = 0;
+	SDL_IOprintf(fReport, "frame,elapse_ms,cost_us,draws,tiles\n");
+	for (size_t ii = 0; ii < replay_costs.size(); ii++)
+	{
+		const Frame_Cost& fc = replay_costs[ii];
+		SDL_IOprintf(fReport, "%zu,%llu,%.1f,%u,%u\n", ii, (unsigned long long)fc.elapse, fc.cost_ns / 1000.0, fc.draws, fc.tiles);
+		total_ns += fc.cost_ns;
+	}
+	SDL_CloseIO(fReport);
+
+	std::vector<Uint64> sorted;
+	sorted.reserve(replay_costs.size());
+	for (auto& it : replay_costs)
+		sorted.push_back(it.cost_ns);
+	std::sort(sorted.begin(), sorted.end());
+	const Uint64 p99 = sorted[(sorted.size() - 1) * 99 / 100];
+
+	Logging_Write("Replay %zu frames, mean %.1f us, p99 %.1f us, max %.1f us, report %s",
+		sorted.size(), total_ns / 1000.0 / sorted.size(), p99 / 1000.0, sorted.back() / 1000.0, path);
+	return true;
+}
+
+bool Trace_Close()
+{
+	if (fTrace == NULL)
+		return false;
+
+	bool ret = SDL_CloseIO(fTrace);
+	fTrace = NULL;
+	return ret;
+}
@@ -0,0 +1,26 @@
+#ifndef __XAC_LOTTERY_TRACE_H_
+#define __XAC_LOTTERY_TRACE_H_
+
+#include <SDL3/SDL.h>
+#include <vector>
+#include <string>
+
+// per frame input bits stored in trace
+#define TRACE_INPUT_ENTER 0x01
+
+// trace file layout (little endian):
+//   "XACT" version(u8) seed(u32) win_w(s32) win_h(s32)
+//   candidate_count(u32) { len(u16) path[len] } ...
+//   frames: { elapse(u32) flags(u8) [win_w(s32) win_h(s32)] [len(u16) winner[len]] } ... until EOF
+//   window size follows when it changed since previous frame, winner when chosen in this frame
+bool Trace_Record_Open(const char* path, Uint32 seed, int win_w, int win_h, const std::vector<std::string>& candidates);
+bool Trace_Record_Frame(Uint64 elapse, Uint8 input, int win_w, int win_h, const char* winner);
+
+bool Trace_Replay_Open(const char* path, Uint32& seed, int& win_w, int& win_h, std::vector<std::string>& candidates);
+bool Trace_Replay_Frame(Uint64& elapse, Uint8& input, int& win_w, int& win_h, std::string& winner);
+void Trace_Replay_Frame_Cost(Uint64 elapse, Uint64 cost_ns, Uint32 draws, Uint32 tiles);
+bool Trace_Replay_Report(const char* path);
+
+bool Trace_Close();
+
+#endif
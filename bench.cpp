@@ -0,0 +1,273 @@
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <memory>
+#include "Candidate.h"
+#include "Logging.h"
+
+// Headless micro benchmarks, one JSON object per line on stdout:
+//   {"benchmark":..., "case":..., "iterations":..., "ns_per_op":..., "draws_per_op":...}
+// Runs on the dummy video driver unless SDL_VIDEO_DRIVER says otherwise.
+
+static const char* BENCH_CANDIDATE_DIR = "bench_candidates";
+static const int BENCH_CANDIDATE_NB = 40;
+static const int BENCH_WIN_H = 1080;
+static const Uint32 BENCH_SEED = 20241019;
+// shortest fold run Lottery_Slide_Show can draw, timed frames stay inside it
+static const Uint64 BENCH_MIN_FOLD_TIME = 6000;
+
+static void Report_(const char* benchmark, const char* bench_case, Uint64 iterations, Uint64 total_ns, double draws)
+{
+    printf("{\"benchmark\":\"%s\",\"case\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.1f,\"draws_per_op\":%.2f}\n",
+        benchmark, bench_case, (unsigned long long)iterations, (double)total_ns / iterations, draws / iterations);
+    fflush(stdout);
+}
+
+// candidate images with a mix of portrait, square and landscape aspect
+static bool Make_Candidates_(std::vector<std::string>& v)
+{
+    SDL_PathInfo pi;
+    if (SDL_GetPathInfo(BENCH_CANDIDATE_DIR, &pi) == false && SDL_CreateDirectory(BENCH_CANDIDATE_DIR) == false)
+        return false;
+
+    const int sizes[][2] = { { 300, 400 }, { 400, 400 }, { 400, 300 } };
+    for (int ii = 0; ii < BENCH_CANDIDATE_NB; ii++)
+    {
+        const int* size = sizes[ii % SDL_arraysize(sizes)];
+        SDL_Surface* surface = SDL_CreateSurface(size[0], size[1], SDL_PIXELFORMAT_RGBA32);
+        if (surface == NULL)
+            return false;
+        SDL_FillSurfaceRect(surface, NULL, 0xFF000000u | (Uint32)(ii * 0x0F1F2F));
+
+        char* path = NULL;
+        SDL_asprintf(&path, "%s/cand-%03d.png", BENCH_CANDIDATE_DIR, ii);
+        bool ok = IMG_SavePNG(surface, path);
+        SDL_free(path);
+        SDL_DestroySurface(surface);
+        if (!ok)
+            return false;
+    }
+
+    return Candidate_List_Files(v, BENCH_CANDIDATE_DIR, "*.png");
+}
+
+static void Bench_Candidate_Enum_()
+{
+    const Uint64 iterations = 200;
+    Uint64 start = SDL_GetTicksNS();
+    for (Uint64 ii = 0; ii < iterations; ii++)
+    {
+        std::vector<std::string> v;
+        Candidate_List_Files(v, BENCH_CANDIDATE_DIR, "*.png");
+        Candidate_List_Files(v, BENCH_CANDIDATE_DIR, "*.jpg");
+    }
+    Report_("candidate_enum", "40_files", iterations, SDL_GetTicksNS() - start, 0.0);
+}
+
+static void Bench_Logging_Write_()
+{
+    const Uint64 iterations = 100000;
+    Uint64 start = SDL_GetTicksNS();
+    for (Uint64 ii = 0; ii < iterations; ii++)
+    {
+        Logging_Write("bench line %llu, remain %d candidates", (unsigned long long)ii, BENCH_CANDIDATE_NB);
+    }
+    Report_("logging_write", "short_line", iterations, SDL_GetTicksNS() - start, 0.0);
+}
+
+static void Bench_Slide_(SDL_Window* window, SDL_Renderer* renderer, const std::vector<std::string>& candidates)
+{
+    const std::vector<SDL_Renderer*> renderers = { renderer };
+    Slide_Output out;
+    out.window = window;
+    out.renderer = renderer;
+    out.back_cache = std::make_shared<Back_Face_Cache>(renderer);
+
+    const Uint64 construct_iterations = 200;
+    Uint64 start = SDL_GetTicksNS();
+    for (Uint64 ii = 0; ii < construct_iterations; ii++)
+    {
+        Slide slide(window, std::make_shared<Shared_Image>(candidates[ii % candidates.size()].c_str(), renderers, window));
+    }
+    Report_("slide_construct", "png_mixed_aspect", construct_iterations, SDL_GetTicksNS() - start, 0.0);
+
+    // one frame is a batch of renders plus present
+    const Uint64 frames = 200;
+    const Uint64 per_frame = 50;
+    for (int turn_back = 0; turn_back < 2; turn_back++)
+    {
+        Slide slide(window, std::make_shared<Shared_Image>(candidates[0].c_str(), renderers, window));
+        slide.Set_Position(100.0f, 100.0f);
+        slide.Set_Turn_Back(turn_back != 0, false);
+        slide.Render(out);
+        start = SDL_GetTicksNS();
+        for (Uint64 ff = 0; ff < frames; ff++)
+        {
+            for (Uint64 ii = 0; ii < per_frame; ii++)
+                slide.Render(out);
+            SDL_RenderPresent(renderer);
+        }
+        Report_("slide_render", turn_back ? "back" : "face", frames * per_frame, SDL_GetTicksNS() - start, (double)frames * per_frame);
+    }
+}
+
+// strip density follows window width, speed follows frame elapse
+static void Bench_Slide_Show_Run_(const std::vector<std::string>& candidates)
+{
+    const int widths[] = { 1280, 1920, 3840 };
+    const Uint64 elapses[] = { 8, 16, 33 };
+    for (int w : widths)
+    {
+        SDL_Window* window = NULL;
+        SDL_Renderer* renderer = NULL;
+        if (!SDL_CreateWindowAndRenderer("XAC Lottery Bench", w, BENCH_WIN_H, 0, &window, &renderer))
+        {
+            Logging_Write("Couldn't create window/renderer: %s", SDL_GetError());
+            continue;
+        }
+
+        for (Uint64 elapse : elapses)
+        {
+            std::vector<std::string> files = candidates;
+            Lottery_Slide_Show show(window, renderer, files, BENCH_SEED);
+            // fill the strip while idle, then start the fold run
+            for (Uint64 t = 0; t <= 2000; t += elapse)
+            {
+                SDL_RenderClear(renderer);
+                show.Run(elapse, false);
+                SDL_RenderPresent(renderer);
+            }
+            SDL_RenderClear(renderer);
+            show.Run(elapse, true);
+            SDL_RenderPresent(renderer);
+
+            // every case measures FOLD_RUN only, whatever the speed
+            const Uint64 frames = BENCH_MIN_FOLD_TIME / elapse;
+            double draws = 0.0;
+            Uint64 start = SDL_GetTicksNS();
+            for (Uint64 ff = 0; ff < frames; ff++)
+            {
+                SDL_RenderClear(renderer);
+                show.Run(elapse, false);
+                SDL_RenderPresent(renderer);
+                draws += show.Get_Render_Stats().draws;
+            }
+            char bench_case[64];
+            SDL_snprintf(bench_case, sizeof(bench_case), "w%d_e%llu", w, (unsigned long long)elapse);
+            Report_("slide_show_run", bench_case, frames, SDL_GetTicksNS() - start, draws);
+        }
+
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+    }
+}
+
+// one simulation driving several windows, images decoded once per slide
+// sizes[0] is the primary window the simulation runs in
+static void Bench_Slide_Show_Outputs_(const std::vector<std::string>& candidates, const char* layout, const int (*sizes)[2], int max_outputs)
+{
+    const Uint64 elapse = 16;
+    // FOLD_RUN only, as in slide_show_run
+    const Uint64 frames = BENCH_MIN_FOLD_TIME / elapse;
+    std::vector<SDL_Window*> windows;
+    std::vector<SDL_Renderer*> renderers;
+    for (int ii = 0; ii < max_outputs; ii++)
+    {
+        SDL_Window* window = NULL;
+        SDL_Renderer* renderer = NULL;
+        if (!SDL_CreateWindowAndRenderer("XAC Lottery Bench", sizes[ii][0], sizes[ii][1], 0, &window, &renderer))
+        {
+            Logging_Write("Couldn't create window/renderer: %s", SDL_GetError());
+            break;
+        }
+        windows.push_back(window);
+        renderers.push_back(renderer);
+    }
+
+    for (size_t output_nb = 1; output_nb <= windows.size(); output_nb++)
+    {
+        std::vector<std::string> files = candidates;
+        Lottery_Slide_Show show(windows[0], renderers[0], files, BENCH_SEED);
+        for (size_t ii = 1; ii < output_nb; ii++)
+            show.Add_Output(windows[ii], renderers[ii]);
+
+        // fill the strip while idle, then start the fold run before timing
+        for (Uint64 t = 0; t <= 2000 + elapse; t += elapse)
+        {
+            for (size_t ii = 0; ii < output_nb; ii++)
+                SDL_RenderClear(renderers[ii]);
+            show.Run(elapse, t > 2000);
+            for (size_t ii = 0; ii < output_nb; ii++)
+                SDL_RenderPresent(renderers[ii]);
+        }
+
+        double draws = 0.0;
+        Uint64 start = SDL_GetTicksNS();
+        for (Uint64 ff = 0; ff < frames; ff++)
+        {
+            for (size_t ii = 0; ii < output_nb; ii++)
+                SDL_RenderClear(renderers[ii]);
+            show.Run(elapse, false);
+            for (size_t ii = 0; ii < output_nb; ii++)
+                SDL_RenderPresent(renderers[ii]);
+            draws += show.Get_Render_Stats().draws;
+        }
+        char bench_case[64];
+        SDL_snprintf(bench_case, sizeof(bench_case), "%s_outputs%zu_e%llu", layout, output_nb, (unsigned long long)elapse);
+        Report_("slide_show_outputs", bench_case, frames, SDL_GetTicksNS() - start, draws);
+    }
+
+    for (size_t ii = 0; ii < windows.size(); ii++)
+    {
+        SDL_DestroyRenderer(renderers[ii]);
+        SDL_DestroyWindow(windows[ii]);
+    }
+}
+
+int main()
+{
+    Logging_Init();
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+
+    if (!SDL_Init(SDL_INIT_VIDEO))
+    {
+        fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    std::vector<std::string> candidates;
+    if (!Make_Candidates_(candidates) || candidates.empty())
+    {
+        fprintf(stderr, "Couldn't create bench candidates: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Window* window = NULL;
+    SDL_Renderer* renderer = NULL;
+    if (!SDL_CreateWindowAndRenderer("XAC Lottery Bench", 1920, BENCH_WIN_H, 0, &window, &renderer))
+    {
+        fprintf(stderr, "Couldn't create window/renderer: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    Bench_Candidate_Enum_();
+    Bench_Slide_(window, renderer, candidates);
+    Bench_Slide_Show_Run_(candidates);
+    const int same_sizes[][2] = { { 1920, 1080 }, { 1920, 1080 }, { 1920, 1080 } };
+    Bench_Slide_Show_Outputs_(candidates, "same", same_sizes, (int)SDL_arraysize(same_sizes));
+    // 16:10 primary, ultra wide main screen, portrait host monitor
+    const int mixed_sizes[][2] = { { 1920, 1200 }, { 2560, 1080 }, { 1080, 1920 } };
+    Bench_Slide_Show_Outputs_(candidates, "mixed", mixed_sizes, (int)SDL_arraysize(mixed_sizes));
+    Bench_Logging_Write_();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    Logging_Close();
+    return 0;
+}
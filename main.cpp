@@ -10,18 +10,26 @@
 #include <random>
 #include "Candidate.h"
 #include "Logging.h"
+#include "Trace.h"
 
 /* We will use this renderer to draw into this window every frame. */
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
-static SDL_Texture* bg_texture = NULL;
+/* primary first, then one per extra display */
+static std::vector<SDL_Window*> windows;
+static std::vector<SDL_Renderer*> renderers;
+static std::shared_ptr<Shared_Image> bg_image = nullptr;
 static const char* TITLE = "XAC Lottery";
 static const char* VERSION = "0.1";
-static const char* CANDIDATE_DIR = "asset\\candidates";
-static const char* BACKGROUIND_PATH = "asset\\background.png";
+static const char* CANDIDATE_DIR = "asset/candidates";
+static const char* BACKGROUIND_PATH = "asset/background.png";
 static std::vector<std::string> vec_candidates;
 static std::shared_ptr<Lottery_Slide_Show> slide_show = nullptr;
 static Uint64 last_tick_ = 0;
+static std::string trace_path_;
+static bool trace_record_ = false;
+static bool trace_replay_ = false;
+static bool multi_display_ = false;
 
 
 #define WINDOW_WIDTH 640
@@ -31,9 +39,7 @@ int win_h;
 
 static SDL_AppResult List_Files_To_Vector_(std::vector<std::string>& v, const char* path, const char* pattern)
 {
-    int filenames_cnt = 0;
-    char** filenames = SDL_GlobDirectory(path, pattern, SDL_GLOB_CASEINSENSITIVE, &filenames_cnt);
-    if (filenames == NULL)
+    if (!Candidate_List_Files(v, path, pattern))
     {
         char* msg = NULL;
         SDL_asprintf(&msg, "SDL_GlobDirectory err: %s", SDL_GetError());
@@ -42,16 +48,6 @@ static SDL_AppResult List_Files_To_Vector_(std::vector<std::string>& v, const ch
         SDL_free(msg);
         return SDL_APP_FAILURE;
     }
-
-    for (int ii = 0; ii < filenames_cnt; ii++)
-    {
-        char* full_path = NULL;
-        SDL_asprintf(&full_path, "%s\\%s", path, filenames[ii]);
-        v.push_back(full_path);
-        SDL_free(full_path);
-    }
-
-    SDL_free(filenames);
     return SDL_APP_CONTINUE;
 }
 
@@ -61,27 +57,101 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
     Logging_Init();
     SDL_SetAppMetadata(TITLE, VERSION, TITLE);
 
+    // --record <trace>: save seed, frame elapse and input
+    // --replay <trace>: feed saved trace back headlessly and report frame cost
+    // --multi-display: same draw fullscreen on every display
+    for (int ii = 1; ii < argc; ii++)
+    {
+        if (SDL_strcmp(argv[ii], "--record") == 0 && ii + 1 < argc)
+        {
+            trace_record_ = true;
+            trace_path_ = argv[++ii];
+        }
+        else if (SDL_strcmp(argv[ii], "--replay") == 0 && ii + 1 < argc)
+        {
+            trace_replay_ = true;
+            trace_path_ = argv[++ii];
+        }
+        else if (SDL_strcmp(argv[ii], "--multi-display") == 0)
+        {
+            multi_display_ = true;
+        }
+    }
+
+    std::random_device rd;
+    Uint32 seed = rd();
+    int trace_w = WINDOW_WIDTH;
+    int trace_h = WINDOW_HEIGHT;
+    if (trace_replay_)
+    {
+        if (!Trace_Replay_Open(trace_path_.c_str(), seed, trace_w, trace_h, vec_candidates))
+            return SDL_APP_FAILURE;
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+    }
+
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         Logging_Write("Couldn't initialize SDL: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
-    if (!SDL_CreateWindowAndRenderer(TITLE, WINDOW_WIDTH, WINDOW_HEIGHT, 0, &window, &renderer)) {
+    if (!SDL_CreateWindowAndRenderer(TITLE, trace_w, trace_h, 0, &window, &renderer)) {
         Logging_Write("Couldn't create window/renderer: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
-    if (!SDL_SetWindowFullscreen(window, true))
+    if (!trace_replay_ && !SDL_SetWindowFullscreen(window, true))
     {
         Logging_Write("Couldn't set fullscreen: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
+    // fullscreen may apply asynchronously, wait so the size below is the one Run sees
+    SDL_SyncWindow(window);
 
     if (!SDL_GetWindowSize(window, &win_w, &win_h))
     {
         Logging_Write("Couldn't get win size: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
+    windows.push_back(window);
+    renderers.push_back(renderer);
+
+    // one fullscreen window per extra display, skip the display holding the first window
+    if (multi_display_ && !trace_replay_)
+    {
+        const SDL_DisplayID primary_display = SDL_GetDisplayForWindow(window);
+        int display_cnt = 0;
+        SDL_DisplayID* displays = SDL_GetDisplays(&display_cnt);
+        for (int ii = 0; displays != NULL && ii < display_cnt; ii++)
+        {
+            SDL_Rect bounds;
+            if (displays[ii] == primary_display || !SDL_GetDisplayBounds(displays[ii], &bounds))
+                continue;
+
+            // created on its display and fullscreen at once, nothing to race with
+            SDL_PropertiesID props = SDL_CreateProperties();
+            SDL_SetStringProperty(props, SDL_PROP_WINDOW_CREATE_TITLE_STRING, TITLE);
+            SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_X_NUMBER, SDL_WINDOWPOS_UNDEFINED_DISPLAY(displays[ii]));
+            SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_Y_NUMBER, SDL_WINDOWPOS_UNDEFINED_DISPLAY(displays[ii]));
+            SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_WIDTH_NUMBER, bounds.w);
+            SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_HEIGHT_NUMBER, bounds.h);
+            SDL_SetBooleanProperty(props, SDL_PROP_WINDOW_CREATE_FULLSCREEN_BOOLEAN, true);
+            SDL_Window* extra_window = SDL_CreateWindowWithProperties(props);
+            SDL_DestroyProperties(props);
+            SDL_Renderer* extra_renderer = extra_window != NULL ? SDL_CreateRenderer(extra_window, NULL) : NULL;
+            if (extra_renderer == NULL)
+            {
+                Logging_Write("Couldn't create window/renderer for display %u: %s", displays[ii], SDL_GetError());
+                if (extra_window != NULL)
+                    SDL_DestroyWindow(extra_window);
+                continue;
+            }
+            SDL_SyncWindow(extra_window);
+            windows.push_back(extra_window);
+            renderers.push_back(extra_renderer);
+        }
+        SDL_free(displays);
+        Logging_Write("Output to %d windows", (int)windows.size());
+    }
 
     int imgFlags = IMG_INIT_PNG | IMG_INIT_JPG;
     if (!(IMG_Init(imgFlags) & imgFlags))
@@ -94,26 +164,22 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         return SDL_APP_FAILURE;
     }
 
-    // load background
-    bg_texture = IMG_LoadTexture(renderer, BACKGROUIND_PATH);
-    if (bg_texture == NULL)
-    {
-        char* msg = NULL;
-        SDL_asprintf(&msg, "IMG_LoadTexture err: %s", SDL_GetError());
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, TITLE, msg, window);
-        Logging_Write("%s", msg);
-        SDL_free(msg);
+    // load background, decoded once for all windows
+    bg_image = std::make_shared<Shared_Image>(BACKGROUIND_PATH, renderers, window);
+    if (bg_image->Get_Width() == 0)
         return SDL_APP_FAILURE;
-    }
 
-    //get all candidate files: png or jpg
-    SDL_AppResult lfret = List_Files_To_Vector_(vec_candidates, CANDIDATE_DIR, "*.png");
-    if (lfret != SDL_APP_CONTINUE)
-        return lfret;
+    //get all candidate files: png or jpg, replay takes them from trace
+    if (!trace_replay_)
+    {
+        SDL_AppResult lfret = List_Files_To_Vector_(vec_candidates, CANDIDATE_DIR, "*.png");
+        if (lfret != SDL_APP_CONTINUE)
+            return lfret;
 
-    lfret = List_Files_To_Vector_(vec_candidates, CANDIDATE_DIR, "*.jpg");
-    if (lfret != SDL_APP_CONTINUE)
-        return lfret;
+        lfret = List_Files_To_Vector_(vec_candidates, CANDIDATE_DIR, "*.jpg");
+        if (lfret != SDL_APP_CONTINUE)
+            return lfret;
+    }
 
     if (vec_candidates.size() < 10)
     {
@@ -127,7 +193,12 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 
     Logging_Write("Initially gather %d candidates", vec_candidates.size());
 
-    slide_show = std::make_shared<Lottery_Slide_Show>(window, renderer, vec_candidates);
+    if (trace_record_ && !Trace_Record_Open(trace_path_.c_str(), seed, win_w, win_h, vec_candidates))
+        return SDL_APP_FAILURE;
+
+    slide_show = std::make_shared<Lottery_Slide_Show>(window, renderer, vec_candidates, seed);
+    for (size_t ii = 1; ii < windows.size(); ii++)
+        slide_show->Add_Output(windows[ii], renderers[ii]);
     last_tick_ = SDL_GetTicks();
     Logging_Write("SDL_AppInit OK");
     return SDL_APP_CONTINUE;  /* carry on with the program! */
@@ -139,6 +210,15 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
     if (event->type == SDL_EVENT_QUIT) {
         return SDL_APP_SUCCESS;  /* end the program, reporting success to the OS. */
     }
+    else if (event->type == SDL_EVENT_WINDOW_CLOSE_REQUESTED)
+    {
+        return SDL_APP_SUCCESS;  /* with several windows SDL_EVENT_QUIT only comes after the last one closes */
+    }
+    else if (event->type == SDL_EVENT_RENDER_TARGETS_RESET || event->type == SDL_EVENT_RENDER_DEVICE_RESET)
+    {
+        if (slide_show)
+            slide_show->Reset_Render_Targets();
+    }
     else if (event->type == SDL_EVENT_KEY_DOWN)
     {
         switch (event->key.key)
@@ -157,24 +237,80 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
 SDL_AppResult SDL_AppIterate(void *appstate)
 {
     SDL_FRect dst_rect;
-    const Uint64 now = SDL_GetTicks();
-    const Uint64 elapsed = now - last_tick_;
-    last_tick_ = now;
+    Uint64 elapsed = 0;
+    bool enter_down = false;
+    std::string recorded_winner;
+    if (trace_replay_)
+    {
+        Uint8 input = 0;
+        int trace_w = win_w;
+        int trace_h = win_h;
+        if (!Trace_Replay_Frame(elapsed, input, trace_w, trace_h, recorded_winner))
+            return SDL_APP_SUCCESS;
+        enter_down = (input & TRACE_INPUT_ENTER) != 0;
+        if (trace_w != win_w || trace_h != win_h)
+        {
+            // a refused or clamped size would simulate a different strip
+            SDL_SetWindowSize(window, trace_w, trace_h);
+            SDL_SyncWindow(window);
+            if (!SDL_GetWindowSize(window, &win_w, &win_h) || win_w != trace_w || win_h != trace_h)
+            {
+                Logging_Write("Replay stopped, window is %dx%d but trace recorded %dx%d", win_w, win_h, trace_w, trace_h);
+                return SDL_APP_FAILURE;
+            }
+        }
+    }
+    else
+    {
+        const Uint64 now = SDL_GetTicks();
+        elapsed = now - last_tick_;
+        last_tick_ = now;
+        enter_down = SDL_GetKeyboardState(NULL)[SDL_SCANCODE_RETURN];
+        // size Run simulates with this frame, recorded when it changes
+        SDL_GetWindowSize(window, &win_w, &win_h);
+    }
+    const Uint64 frame_start = SDL_GetTicksNS();
 
-    /* as you can see from this, rendering draws over whatever was drawn before it. */
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);  /* black, full alpha */
-    SDL_RenderClear(renderer);  /* start with a blank canvas. */
+    for (size_t ii = 0; ii < windows.size(); ii++)
+    {
+        /* as you can see from this, rendering draws over whatever was drawn before it. */
+        SDL_SetRenderDrawColor(renderers[ii], 0, 0, 0, SDL_ALPHA_OPAQUE);  /* black, full alpha */
+        SDL_RenderClear(renderers[ii]);  /* start with a blank canvas. */
 
-    // backgroung
-    dst_rect.x = 0.0f;
-    dst_rect.y = 0.0f;
-    dst_rect.w = (float)win_w;
-    dst_rect.h = (float)win_h;
-    SDL_RenderTexture(renderer, bg_texture, NULL, &dst_rect);
+        // backgroung, letterboxed to the slide show area of this window
+        if (!slide_show->Get_Output_Area(windows[ii], dst_rect))
+        {
+            int w, h;
+            SDL_GetWindowSize(windows[ii], &w, &h);
+            dst_rect.x = 0.0f;
+            dst_rect.y = 0.0f;
+            dst_rect.w = (float)w;
+            dst_rect.h = (float)h;
+        }
+        SDL_RenderTexture(renderers[ii], bg_image->Get_Texture(renderers[ii]), NULL, &dst_rect);
+    }
+
+    slide_show->Run(elapsed, enter_down);
+    std::string winner;
+    const bool has_winner = slide_show->Take_Winner(winner);
+    if (trace_record_)
+    {
+        Trace_Record_Frame(elapsed, enter_down ? TRACE_INPUT_ENTER : 0, win_w, win_h, has_winner ? winner.c_str() : NULL);
+    }
+    else if (trace_replay_ && (has_winner || !recorded_winner.empty()))
+    {
+        Logging_Write("Replay winner %s, recorded %s%s", has_winner ? winner.c_str() : "(none)",
+            recorded_winner.empty() ? "(none)" : recorded_winner.c_str(), winner == recorded_winner ? "" : " MISMATCH");
+    }
 
-    slide_show->Run(elapsed);
+    for (auto it : renderers)
+        SDL_RenderPresent(it);  /* put it all on the screen! */
 
-    SDL_RenderPresent(renderer);  /* put it all on the screen! */
+    if (trace_replay_)
+    {
+        const Render_Stats& stats = slide_show->Get_Render_Stats();
+        Trace_Replay_Frame_Cost(elapsed, SDL_GetTicksNS() - frame_start, stats.draws, stats.tiles);
+    }
 
     return SDL_APP_CONTINUE;  /* carry on with the program! */
 }
@@ -184,7 +320,13 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
 {    
     Logging_Write("SDL_AppQuit");
     slide_show = nullptr;
-    SDL_DestroyTexture(bg_texture);
+    if (trace_replay_)
+    {
+        std::string report_path = trace_path_ + ".csv";
+        Trace_Replay_Report(report_path.c_str());
+    }
+    Trace_Close();
+    bg_image = nullptr;
     /* SDL will clean up the window/renderer for us. */
     IMG_Quit();
     Logging_Close();